@@ -0,0 +1,427 @@
+#!/usr/bin/env python3
+"""Generate closed .cub scenes of arbitrary size for stress tests.
+
+    tools/gen_map.py maze 4096 4096 --seed 7 -o maze4k.cub
+    tools/gen_map.py ragged 1024 768 --doors 3 --sprites 1 > ragged.cub
+    tools/gen_map.py --check maze4k.cub
+
+Styles:
+    maze      perfect maze (binary-tree carving), one-cell corridors
+    arena     open room with scattered pillars
+    corridor  serpentine of long horizontal corridors, joined at random
+              points near alternating ends
+    ragged    arena inside a jagged, space-padded outline, with sealed
+              void holes, and rows of varying length
+
+Every map is closed by construction: no walkable cell touches a space or
+the edge, diagonals included. --doors places 'D' in one-cell passages and
+--sprites places '2' on free cells (bonus symbols). The same seed always
+produces the same file.
+
+--check validates an existing .cub: the six identifiers, each once, with
+R,G,B colours, then the map, last and without empty lines, closed by the
+same rule. It exits non-zero on the first problem.
+"""
+
+import argparse
+import random
+import sys
+
+WALKABLE = b"0NSEWD2"
+PLAYERS = b"NSEW"
+HEADER = (
+    b"NO ./textures/north.xpm\n"
+    b"SO ./textures/south.xpm\n"
+    b"WE ./textures/west.xpm\n"
+    b"EA ./textures/east.xpm\n"
+    b"F 220,100,0\n"
+    b"C 225,30,0\n"
+    b"\n"
+)
+MIN_SIDE = 8
+PLAYER_ROOM = 16
+PLAYER_TRIES = 1000
+IDENTIFIERS = (b"NO", b"SO", b"WE", b"EA", b"F", b"C")
+VOID = bytes(int(c == ord(" ")) for c in range(256))
+FLOOR = bytes(int(c in WALKABLE) for c in range(256))
+UNKNOWN = bytes(c for c in range(256) if c not in b" 1" + WALKABLE)
+
+
+def walled_box(width, height):
+    wall = bytearray(b"1" * width)
+    grid = [bytearray(wall)]
+    inner = b"1" + b"0" * (width - 2) + b"1"
+    grid.extend(bytearray(inner) for _ in range(height - 2))
+    grid.append(wall)
+    return grid
+
+
+def gen_maze(width, height, rng):
+    """Binary-tree maze: every cell opens either north or east."""
+    ncol = (width - 1) // 2
+    nrow = (height - 1) // 2
+    grid = [bytearray(b"1" * width) for _ in range(height)]
+    cells = b"0" * ncol
+    for r in range(nrow):
+        y = 2 * r + 1
+        row = grid[y]
+        row[1:2 * ncol:2] = cells
+        if r == 0:
+            row[2:2 * ncol - 1:2] = b"0" * (ncol - 1)
+            continue
+        bits = format(rng.getrandbits(ncol), "0%db" % ncol).encode()
+        east = bits[:ncol - 1].translate(bytes.maketrans(b"01", b"10"))
+        row[2:2 * ncol - 1:2] = east
+        north = bytearray(bits)
+        north[ncol - 1] = ord("0")
+        grid[y - 1][1:2 * ncol:2] = north
+    return grid
+
+
+def add_pillars(grid, percent, rng):
+    """Put single-cell pillars on a 2-cell lattice so they never touch."""
+    height = len(grid)
+    for y in range(2, height - 2, 2):
+        row = grid[y]
+        width = len(row)
+        for x in range(2, width - 2, 2):
+            if row[x] == ord("0") and rng.random() * 100 < percent:
+                row[x] = ord("1")
+
+
+def gen_arena(width, height, rng, pillars):
+    grid = walled_box(width, height)
+    add_pillars(grid, pillars, rng)
+    return grid
+
+
+def gen_corridor(width, height, rng):
+    """
+    Horizontal corridors on odd rows, each joined to the next by one gap
+    drawn at random from the outer third of the width, alternating sides,
+    so the path still sweeps most of every row.
+    """
+    grid = [bytearray(b"1" * width) for _ in range(height)]
+    last = (height - 2) | 1
+    if last > height - 2:
+        last -= 2
+    third = max(1, (width - 2) // 3)
+    left = True
+    for y in range(1, last + 1, 2):
+        grid[y][1:width - 1] = b"0" * (width - 2)
+        if y + 2 <= last:
+            if left:
+                x = rng.randint(1, third)
+            else:
+                x = rng.randint(width - 1 - third, width - 2)
+            grid[y + 1][x] = ord("0")
+            left = not left
+    return grid
+
+
+def ragged_edges(width, height, rng):
+    """Random-walk left/right wall columns, one step at most per row."""
+    limit = max(1, width // 4)
+    left = [0] * height
+    right = [width - 1] * height
+    for y in range(1, height):
+        left[y] = min(limit, max(0, left[y - 1] + rng.randint(-1, 1)))
+        right[y] = max(width - 1 - limit,
+                       min(width - 1, right[y - 1] + rng.randint(-1, 1)))
+    return left, right
+
+
+def gen_ragged(width, height, rng, pillars):
+    """
+    Row y is voids up to left[y], then a wall run long enough to cover
+    left[y - 1..y + 1], the floor, and the mirrored run on the right. No
+    floor cell can therefore see a void cell of its own or adjacent row.
+    """
+    left, right = ragged_edges(width, height, rng)
+    grid = []
+    for y in range(height):
+        lo = left[y]
+        hi = right[y]
+        if y == 0 or y == height - 1:
+            grid.append(bytearray(b" " * lo + b"1" * (hi - lo + 1)))
+            continue
+        lw = max(left[y - 1:y + 2])
+        rw = min(right[y - 1:y + 2])
+        grid.append(bytearray(b" " * lo + b"1" * (lw - lo + 1)
+                              + b"0" * (rw - lw - 1) + b"1" * (hi - rw + 1)))
+    add_holes(grid, rng)
+    add_pillars(grid, pillars, rng)
+    return grid
+
+
+def region_is_floor(grid, x, y, w, h):
+    for row in grid[y:y + h]:
+        if len(row) < x + w or row[x:x + w].strip(b"0"):
+            return False
+    return True
+
+
+def add_holes(grid, rng):
+    """Sealed void islands: a ring of walls around spaces, away from others."""
+    height = len(grid)
+    width = max(len(row) for row in grid)
+    tries = max(1, width * height // 2048)
+    for _ in range(tries):
+        w = rng.randint(3, 8)
+        h = rng.randint(3, 8)
+        x = rng.randint(1, max(1, width - w - 2))
+        y = rng.randint(1, max(1, height - h - 2))
+        if not region_is_floor(grid, x - 1, y - 1, w + 2, h + 2):
+            continue
+        for row in grid[y:y + h]:
+            row[x:x + w] = b"1" * w
+        for row in grid[y + 1:y + h - 1]:
+            row[x + 1:x + w - 1] = b" " * (w - 2)
+
+
+def is_passage(grid, x, y):
+    row = grid[y]
+    wall = ord("1")
+    if row[x - 1] == wall and row[x + 1] == wall:
+        return True
+    return grid[y - 1][x] == wall and grid[y + 1][x] == wall
+
+
+def next_to_player(grid, x, y):
+    """True when a 4-neighbour is the player; rows may be short."""
+    for nx, ny in ((x - 1, y), (x + 1, y), (x, y - 1), (x, y + 1)):
+        if grid[ny][nx:nx + 1] in (b"N", b"S", b"E", b"W"):
+            return True
+    return False
+
+
+def scatter(grid, percent, rng, symbol, passages_only):
+    """Replace about percent% of the floor cells visited at random."""
+    height = len(grid)
+    width = max(len(row) for row in grid)
+    count = int(width * height * percent / 100)
+    floor = ord("0")
+    for _ in range(count):
+        y = rng.randint(1, height - 2)
+        row = grid[y]
+        x = rng.randint(1, len(row) - 2)
+        if row[x] != floor:
+            continue
+        if passages_only and not is_passage(grid, x, y):
+            continue
+        if next_to_player(grid, x, y):
+            continue
+        row[x] = ord(symbol)
+
+
+def reach(grid, x, y, limit):
+    """Count floor cells 4-connected to (x, y), stopping at limit."""
+    floor = ord("0")
+    seen = {(x, y)}
+    todo = [(x, y)]
+    while todo and len(seen) < limit:
+        x, y = todo.pop()
+        for nx, ny in ((x - 1, y), (x + 1, y), (x, y - 1), (x, y + 1)):
+            row = grid[ny]
+            if (nx, ny) not in seen and nx < len(row) and row[nx] == floor:
+                seen.add((nx, ny))
+                todo.append((nx, ny))
+    return len(seen)
+
+
+def place_player(grid, rng):
+    """
+    Drop the player on a random floor cell whose 4-connected region holds
+    at least PLAYER_ROOM cells, so a notch sealed by a pillar is never
+    picked. Falls back to the roomiest cell seen.
+    """
+    height = len(grid)
+    best = None
+    for _ in range(PLAYER_TRIES):
+        y = rng.randint(1, height - 2)
+        x = rng.randint(1, len(grid[y]) - 2)
+        if grid[y][x] != ord("0"):
+            continue
+        room = reach(grid, x, y, PLAYER_ROOM)
+        if best is None or room > best[0]:
+            best = (room, x, y)
+        if room == PLAYER_ROOM:
+            break
+    if best is None:
+        raise SystemExit("gen_map: no floor cell for the player")
+    grid[best[2]][best[1]] = rng.choice(PLAYERS)
+
+
+def generate(args):
+    rng = random.Random(args.seed)
+    if args.style == "maze":
+        grid = gen_maze(args.width, args.height, rng)
+    elif args.style == "arena":
+        grid = gen_arena(args.width, args.height, rng, args.pillars)
+    elif args.style == "corridor":
+        grid = gen_corridor(args.width, args.height, rng)
+    else:
+        grid = gen_ragged(args.width, args.height, rng, args.pillars)
+    place_player(grid, rng)
+    scatter(grid, args.doors, rng, "D", True)
+    scatter(grid, args.sprites, rng, "2", False)
+    return grid
+
+
+def column_mask(row, width, table):
+    """Pack one byte per column into an int, 0x01 where table says so."""
+    padded = bytes(row).ljust(width, b" ")
+    return int.from_bytes(padded.translate(table), "big")
+
+
+def check_grid(grid):
+    """Return an error string, or None when the map is closed and valid."""
+    if not grid:
+        return "empty map"
+    width = max(len(row) for row in grid) + 2
+    players = 0
+    for y, row in enumerate(grid):
+        if len(bytes(row).translate(None, UNKNOWN)) != len(row):
+            return "map line %d: unexpected character" % (y + 1)
+        players += sum(row.count(c) for c in PLAYERS)
+    if players != 1:
+        return "expected one player, found %d" % players
+    edge = (1 << (8 * width)) - 1
+    above = edge
+    here = column_mask(b" " + grid[0], width, VOID)
+    for y in range(len(grid)):
+        if y + 1 < len(grid):
+            below = column_mask(b" " + grid[y + 1], width, VOID)
+        else:
+            below = edge
+        near = above | here | below
+        near |= (near << 8) | (near >> 8)
+        if column_mask(b" " + grid[y], width, FLOOR) & near:
+            return "map line %d: not closed" % (y + 1)
+        above, here = here, below
+    return None
+
+
+def check_color(value):
+    parts = value.split(b",")
+    if len(parts) != 3:
+        return False
+    for part in parts:
+        part = part.strip()
+        if not part.isdigit() or int(part) > 255:
+            return False
+    return True
+
+
+def check_identifier(word, seen):
+    """Return an error string for one NO/SO/WE/EA/F/C line, or None."""
+    name = word[0]
+    if name in seen:
+        return "duplicate identifier %s" % name.decode()
+    seen.add(name)
+    if len(word) < 2 or not word[1].strip():
+        return "identifier %s has no value" % name.decode()
+    if name in (b"F", b"C") and not check_color(word[1]):
+        return "identifier %s: expected R,G,B in 0-255" % name.decode()
+    return None
+
+
+def read_map(lines):
+    """
+    Split a .cub into its six identifiers and the map, which must come
+    last and hold no empty line. Returns (error, grid).
+    """
+    seen = set()
+    i = 0
+    while i < len(lines) and len(seen) < len(IDENTIFIERS):
+        word = lines[i].split(None, 1)
+        i += 1
+        if not word:
+            continue
+        if word[0] not in IDENTIFIERS:
+            break
+        error = check_identifier(word, seen)
+        if error:
+            return error, None
+    if len(seen) < len(IDENTIFIERS):
+        missing = [n for n in IDENTIFIERS if n not in seen]
+        return "missing identifier %s" % missing[0].decode(), None
+    while i < len(lines) and not lines[i].strip():
+        i += 1
+    if i < len(lines) and lines[i].split(None, 1)[0] in IDENTIFIERS:
+        return check_identifier(lines[i].split(None, 1), seen), None
+    grid = lines[i:]
+    while grid and not grid[-1].strip():
+        grid.pop()
+    for y, row in enumerate(grid):
+        if not row:
+            return "map line %d: empty line inside the map" % (y + 1), None
+        words = row.split(None, 1)
+        if words and words[0] in IDENTIFIERS:
+            return "map line %d: identifier after the map" % (y + 1), None
+    return None, grid
+
+
+def check_file(path):
+    try:
+        with open(path, "rb") as f:
+            lines = f.read().split(b"\n")
+    except OSError as e:
+        return e.strerror
+    error, grid = read_map(lines)
+    if error:
+        return error
+    return check_grid(grid)
+
+
+def parse_args(argv):
+    p = argparse.ArgumentParser(
+        description="Generate closed .cub scenes for stress tests.")
+    p.add_argument("style", nargs="?",
+                   choices=("maze", "arena", "corridor", "ragged"))
+    p.add_argument("width", nargs="?", type=int)
+    p.add_argument("height", nargs="?", type=int)
+    p.add_argument("--seed", type=int, default=0)
+    p.add_argument("--pillars", type=float, default=10,
+                   help="percent of pillar slots filled (arena, ragged)")
+    p.add_argument("--doors", type=float, default=0,
+                   help="percent of cells tried as doors")
+    p.add_argument("--sprites", type=float, default=0,
+                   help="percent of cells tried as sprites")
+    p.add_argument("-o", "--output", help="write here instead of stdout")
+    p.add_argument("--check", metavar="FILE",
+                   help="validate an existing .cub map and exit")
+    args = p.parse_args(argv)
+    if args.check:
+        return args
+    if args.style is None or args.width is None or args.height is None:
+        p.error("style, width and height are required")
+    if args.width < MIN_SIDE or args.height < MIN_SIDE:
+        p.error("width and height must be at least %d" % MIN_SIDE)
+    return args
+
+
+def main(argv):
+    args = parse_args(argv)
+    if args.check:
+        error = check_file(args.check)
+        if error:
+            sys.stderr.write("Error\n%s: %s\n" % (args.check, error))
+            return 1
+        return 0
+    grid = generate(args)
+    error = check_grid(grid)
+    if error:
+        raise SystemExit("gen_map: internal error, %s" % error)
+    out = open(args.output, "wb") if args.output else sys.stdout.buffer
+    out.write(HEADER)
+    for row in grid:
+        out.write(row)
+        out.write(b"\n")
+    if args.output:
+        out.close()
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv[1:]))
@@ -0,0 +1,303 @@
+/*
+** Present-path benchmark for the vendored MiniLibX.
+**
+** Times mlx_put_image_to_window + mlx_do_sync for each image type
+** (MLX_TYPE_XIMAGE, MLX_TYPE_SHM, MLX_TYPE_SHM_PIXMAP), forced through
+** t_xvar's use_xshm and pshm_format, and prints which type mlx_new_image
+** really returned.
+**
+** Build against the extracted, patched archive:
+**   tar xzf minilibx/minilibx-linux.tgz -C /tmp
+**   for p in minilibx/patches/0*.patch; do
+**     patch -d /tmp/minilibx-linux -p1 < $p; done
+**   make -C /tmp/minilibx-linux -f Makefile.mk INC=/usr/include
+**   cc -O2 -I/tmp/minilibx-linux tools/mlx_present_bench.c \
+**     /tmp/minilibx-linux/libmlx.a -lXext -lX11 -o present_bench
+**
+** Run:
+**   Xvfb :9 -screen 0 1920x1080x24 &
+**   DISPLAY=:9 ./present_bench                  all types, all sizes
+**   DISPLAY=:9 ./present_bench shm 1280x720     one type, one size
+**
+** "diff" compares mlx_put_image_to_window with mlx_put_image_diff
+** (patch 0003) on XImage images, with only a moving box of 1/16 of the
+** frame changing each frame. A TCP display on loopback is what a remote
+** game sees, since mlx_int_deal_shm turns MIT-SHM off for it:
+**   Xvfb :9 -listen tcp -screen 0 1920x1080x24 &
+**   DISPLAY=127.0.0.1:9 ./present_bench diff
+*/
+
+#include	<sys/time.h>
+#include	"mlx_int.h"
+#include	"mlx.h"
+
+#define WARMUP	100
+#define FRAMES	1000
+
+static const char	*g_type_name[] = {"none", "ximage", "shm", "shm_pixmap"};
+
+typedef struct	s_server
+{
+	t_xvar		*xvar;
+	int			use_xshm;
+	int			pshm_format;
+	int			diff;
+}				t_server;
+
+static long	now_us(void)
+{
+	struct timeval	tv;
+
+	gettimeofday(&tv, 0);
+	return (tv.tv_sec * 1000000L + tv.tv_usec);
+}
+
+static int	cmp_long(const void *a, const void *b)
+{
+	long	x;
+	long	y;
+
+	x = *(const long *)a;
+	y = *(const long *)b;
+	return ((x > y) - (x < y));
+}
+
+/*
+** Put back what mlx_init detected, then turn off what the requested
+** type must not use. Returns 0 when the server cannot offer the type.
+*/
+
+static int	force_type(t_server *srv, int type)
+{
+	srv->xvar->use_xshm = srv->use_xshm;
+	srv->xvar->pshm_format = srv->pshm_format;
+	if (type == MLX_TYPE_XIMAGE)
+		srv->xvar->use_xshm = 0;
+	else if (!srv->use_xshm)
+		return (0);
+	else if (type == MLX_TYPE_SHM)
+		srv->xvar->pshm_format = -1;
+	else if (srv->pshm_format != ZPixmap)
+		return (0);
+	return (1);
+}
+
+/*
+** Every byte changes every frame, so no path can skip unchanged data.
+*/
+
+static void	touch_frame(t_img *img, int frame)
+{
+	memset(img->data, frame & 0xFF, img->size_line * img->height);
+}
+
+/*
+** Partial update: a quarter-width, quarter-height box sliding along the
+** diagonal, so about 1/16 of the frame changes.
+*/
+
+static void	touch_box(t_img *img, int frame)
+{
+	int	w;
+	int	h;
+	int	x;
+	int	y;
+
+	w = img->width / 4;
+	h = img->height / 4;
+	x = frame % (img->width - w);
+	y = frame % (img->height - h);
+	while (h--)
+		memset(img->data + (y + h) * img->size_line + x * (img->bpp / 8),
+			frame & 0xFF, w * (img->bpp / 8));
+}
+
+static void	run_frames(t_server *srv, void *win, t_img *img, long *lat)
+{
+	int		i;
+	long	t0;
+
+	i = 0;
+	while (i < WARMUP + FRAMES)
+	{
+		if (srv->diff)
+			touch_box(img, i);
+		else
+			touch_frame(img, i);
+		t0 = now_us();
+		if (srv->diff == 2)
+			mlx_put_image_diff(srv->xvar, win, img, 0, 0);
+		else
+			mlx_put_image_to_window(srv->xvar, win, img, 0, 0);
+		mlx_do_sync(srv->xvar);
+		if (i >= WARMUP)
+			lat[i - WARMUP] = now_us() - t0;
+		i++;
+	}
+}
+
+static void	report(t_server *srv, int type, t_img *img, long *lat)
+{
+	static const char	*mode[] = {"", " box put", " box diff"};
+
+	long	total;
+	int		i;
+
+	total = 0;
+	i = 0;
+	while (i < FRAMES)
+		total += lat[i++];
+	qsort(lat, FRAMES, sizeof(*lat), cmp_long);
+	printf("%-10s got=%-10s %4dx%-4d bpp=%2d  %8.1f presents/s"
+		"  median %6ld us  p99 %6ld us%s\n",
+		g_type_name[type], g_type_name[img->type], img->width, img->height,
+		img->bpp, FRAMES * 1e6 / (total ? total : 1),
+		lat[FRAMES / 2], lat[FRAMES * 99 / 100], mode[srv->diff]);
+}
+
+static void	bench(t_server *srv, int type, int width, int height)
+{
+	void	*win;
+	t_img	*img;
+	long	lat[FRAMES];
+
+	if (!force_type(srv, type))
+	{
+		printf("%-10s unavailable on this server\n", g_type_name[type]);
+		return ;
+	}
+	win = mlx_new_window(srv->xvar, width, height, "present_bench");
+	img = mlx_new_image(srv->xvar, width, height);
+	if (!win || !img)
+	{
+		printf("%-10s %dx%d: window or image creation failed\n",
+			g_type_name[type], width, height);
+		if (img)
+			mlx_destroy_image(srv->xvar, img);
+		if (win)
+			mlx_destroy_window(srv->xvar, win);
+		return ;
+	}
+	run_frames(srv, win, img, lat);
+	report(srv, type, img, lat);
+	if (srv->diff)
+	{
+		srv->diff = 2;
+		run_frames(srv, win, img, lat);
+		report(srv, type, img, lat);
+		srv->diff = 1;
+	}
+	mlx_destroy_image(srv->xvar, img);
+	mlx_destroy_window(srv->xvar, win);
+}
+
+static void	print_server(t_server *srv)
+{
+	t_img	*img;
+
+	img = mlx_new_image(srv->xvar, 64, 64);
+	printf("depth=%d use_xshm=%d pshm_format=%d default image type: %s\n",
+		srv->xvar->depth, srv->use_xshm, srv->pshm_format,
+		img ? g_type_name[img->type] : "none (mlx_new_image failed)");
+	if (img)
+		mlx_destroy_image(srv->xvar, img);
+}
+
+static void	bench_sizes(t_server *srv, int type, int *dims, int n)
+{
+	int	j;
+
+	j = 0;
+	while (j < n)
+	{
+		bench(srv, type, dims[j], dims[j + 1]);
+		j += 2;
+	}
+}
+
+static int	parse_type(char *arg)
+{
+	int	type;
+
+	type = MLX_TYPE_SHM_PIXMAP;
+	while (type > 0 && strcmp(arg, g_type_name[type]))
+		type--;
+	return (type);
+}
+
+/*
+** Fills types[] (indexed by MLX_TYPE_*), dims[] (width, height pairs)
+** and srv->diff.
+** Returns the number of ints in dims[], or -1 on a bad argument.
+*/
+
+static int	parse_args(int ac, char **av, int *types, int *dims, t_server *srv)
+{
+	static const int	sizes[] = {640, 480, 1280, 720, 1920, 1080};
+	int					n;
+	int					i;
+
+	n = 0;
+	i = 0;
+	while (++i < ac)
+	{
+		if (!strcmp(av[i], "diff"))
+			srv->diff = 1;
+		else if (parse_type(av[i]))
+			types[parse_type(av[i])] = 1;
+		else if (n < 31 && sscanf(av[i], "%dx%d", &dims[n], &dims[n + 1]) == 2
+			&& dims[n] > 0 && dims[n + 1] > 0)
+			n += 2;
+		else
+			return (-1);
+	}
+	if (srv->diff)
+	{
+		memset(types, 0, 4 * sizeof(*types));
+		types[MLX_TYPE_XIMAGE] = 1;
+	}
+	else if (!types[MLX_TYPE_XIMAGE] && !types[MLX_TYPE_SHM]
+		&& !types[MLX_TYPE_SHM_PIXMAP])
+		types[MLX_TYPE_XIMAGE] = types[MLX_TYPE_SHM]
+			= types[MLX_TYPE_SHM_PIXMAP] = 1;
+	if (n)
+		return (n);
+	memcpy(dims, sizes, sizeof(sizes));
+	return (sizeof(sizes) / sizeof(*sizes));
+}
+
+int	main(int ac, char **av)
+{
+	int			types[4];
+	int			dims[32];
+	int			n;
+	int			i;
+	t_server	srv;
+
+	memset(types, 0, sizeof(types));
+	srv.diff = 0;
+	if ((n = parse_args(ac, av, types, dims, &srv)) < 0)
+	{
+		fprintf(stderr, "usage: %s [ximage|shm|shm_pixmap ...|diff] "
+			"[WxH ...]\n", av[0]);
+		return (2);
+	}
+	if (!(srv.xvar = mlx_init()))
+	{
+		fprintf(stderr, "present_bench: cannot open display\n");
+		return (1);
+	}
+	srv.use_xshm = srv.xvar->use_xshm;
+	srv.pshm_format = srv.xvar->pshm_format;
+	print_server(&srv);
+	i = MLX_TYPE_XIMAGE;
+	while (i <= MLX_TYPE_SHM_PIXMAP)
+	{
+		if (types[i])
+			bench_sizes(&srv, i, dims, n);
+		i++;
+	}
+	mlx_destroy_display(srv.xvar);
+	free(srv.xvar);
+	return (0);
+}